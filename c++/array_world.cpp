@@ -0,0 +1,129 @@
+#include "layouts.cpp"
+#include "memory.cpp"
+#include "seeding.cpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// An alternative to World storing one byte per cell in a flat array,
+// with the order of cells in memory decided by `Layout`
+template <typename Layout>
+class ArrayWorld {
+  public:
+    uint32_t tick = 0;
+
+    ArrayWorld(uint32_t width, uint32_t height):
+      width(width),
+      height(height),
+      layout(width, height),
+      current(layout.size(), 0),
+      next(layout.size(), 0) {
+      populate_cells();
+    }
+
+    void dotick() {
+      // Cells are visited in storage order, so reads stay close together
+      layout.each([&](uint32_t x, uint32_t y, size_t index) {
+        auto alive_neighbours = count_alive_neighbours(x, y, index);
+        auto alive = current[index];
+        if (!alive && alive_neighbours == 3) {
+          next[index] = 1;
+        } else if (alive_neighbours < 2 || alive_neighbours > 3) {
+          next[index] = 0;
+        } else {
+          next[index] = alive;
+        }
+      });
+
+      std::swap(current, next);
+      tick++;
+    }
+
+    std::string render() {
+      std::string rendering(render_size(), ' ');
+      render_into(rendering.data());
+      return rendering;
+    }
+
+    size_t render_size() {
+      return (size_t) width * height + height;
+    }
+
+    size_t render_into(char* rendering) {
+      auto start = rendering;
+      for (auto y = 0u; y < height; y++) {
+        for (auto x = 0u; x < width; x++) {
+          *rendering++ = current[layout.index(x, y)] ? 'o' : ' ';
+        }
+        *rendering++ = '\n';
+      }
+      return rendering - start;
+    }
+
+    void snapshot(std::vector<uint64_t>& rows) {
+      auto words = (width + 63) / 64;
+      std::fill(rows.begin(), rows.end(), 0);
+      for (auto y = 0u; y < height; y++) {
+        for (auto x = 0u; x < width; x++) {
+          if (current[layout.index(x, y)]) {
+            rows[(size_t) y * words + x / 64] |= uint64_t(1) << (x % 64);
+          }
+        }
+      }
+    }
+
+    MemoryUsage memory_usage() {
+      auto usage = MemoryUsage((uint64_t) width * height);
+      usage.add("Current", current.capacity());
+      usage.add("Next", next.capacity());
+      usage.add("Layout", layout.overhead());
+      return usage;
+    }
+
+  private:
+    const uint32_t width;
+    const uint32_t height;
+    Layout layout;
+    std::vector<uint8_t> current;
+    std::vector<uint8_t> next;
+
+    static constexpr std::array<std::pair<int, int>, 8> DIRECTIONS = {{
+      {-1, 1},  {0, 1},  {1, 1},  // above
+      {-1, 0},           {1, 0},  // sides
+      {-1, -1}, {0, -1}, {1, -1}, // below
+    }};
+
+    uint32_t count_alive_neighbours(uint32_t x, uint32_t y, size_t index) {
+      // Most cells can read their neighbours at fixed offsets
+      auto stride = layout.stride(x, y);
+      if (stride != 0) {
+        auto above = current.data() + index - stride;
+        auto cells = current.data() + index;
+        auto below = current.data() + index + stride;
+        return above[-1] + above[0] + above[1]
+          + cells[-1] + cells[1]
+          + below[-1] + below[0] + below[1];
+      }
+
+      uint32_t alive_neighbours = 0;
+      for (auto& [rel_x, rel_y] : DIRECTIONS) {
+        auto nx = x + rel_x;
+        auto ny = y + rel_y;
+        if (nx >= width || ny >= height) {
+          continue; // Out of bounds, including wrapping below zero
+        }
+
+        alive_neighbours += current[layout.neighbour(index, x, y, rel_x, rel_y)];
+      }
+      return alive_neighbours;
+    }
+
+    void populate_cells() {
+      Seeding::populate(width, height, [this](uint32_t x, uint32_t y) {
+        current[layout.index(x, y)] = 1;
+      });
+    }
+};
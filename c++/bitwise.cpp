@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+// Steps 64 cells at once, one cell per bit, with bit `b` of a word being
+// the cell at column `b` within that word
+class Bitwise {
+  public:
+    // Shifts a row so each bit holds its left (west) neighbour
+    static uint64_t west(uint64_t previous, uint64_t current) {
+      return (current << 1) | (previous >> 63);
+    }
+
+    // Shifts a row so each bit holds its right (east) neighbour
+    static uint64_t east(uint64_t current, uint64_t following) {
+      return (current >> 1) | (following << 63);
+    }
+
+    // Each argument is the word to the west, at, and east of the cells
+    static uint64_t evolve(
+      uint64_t above_w, uint64_t above, uint64_t above_e,
+      uint64_t row_w, uint64_t row, uint64_t row_e,
+      uint64_t below_w, uint64_t below, uint64_t below_e
+    ) {
+      // Bit-sliced counters; `fours` sticks once a cell reaches 4 neighbours
+      uint64_t ones = 0;
+      uint64_t twos = 0;
+      uint64_t fours = 0;
+
+      auto add = [&](uint64_t neighbours) {
+        auto carry = ones & neighbours;
+        ones ^= neighbours;
+        fours |= twos & carry;
+        twos ^= carry;
+      };
+
+      add(west(above_w, above));
+      add(above);
+      add(east(above, above_e));
+      add(west(row_w, row));
+      add(east(row, row_e));
+      add(west(below_w, below));
+      add(below);
+      add(east(below, below_e));
+
+      // Alive with 3 neighbours, or already alive with 2
+      return ~fours & twos & (ones | row);
+    }
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Encoding shared by Recorder and Replayer. Generations are packed rows
+// of 64 cells per word (bit `b` of word `i` is column `i * 64 + b`),
+// written as little endian bytes and run-length encoded as pairs of
+// (varint zero bytes, varint literal bytes, literal bytes)
+class Codec {
+  public:
+    static constexpr char MAGIC[4] = {'G', 'O', 'L', 'R'};
+
+    static void put_varint(std::string& out, uint64_t value) {
+      while (value >= 0x80) {
+        out += (char) ((value & 0x7f) | 0x80);
+        value >>= 7;
+      }
+      out += (char) value;
+    }
+
+    // Returns false when `in` runs out before the varint ends
+    static bool get_varint(std::string_view& in, uint64_t& value) {
+      value = 0;
+      for (auto shift = 0; shift < 64 && !in.empty(); shift += 7) {
+        auto byte = (uint8_t) in.front();
+        in.remove_prefix(1);
+        value |= (uint64_t) (byte & 0x7f) << shift;
+        if (byte < 0x80) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // Whole zero words, the bulk of most deltas, are skipped 8 bytes at a time
+    static void compress(const uint64_t* words, size_t count, std::string& out) {
+      auto size = count * sizeof(uint64_t);
+      auto byte = [&](size_t i) -> uint8_t {
+        return words[i >> 3] >> ((i & 7) << 3);
+      };
+
+      size_t i = 0;
+      while (i < size) {
+        auto zeros = i;
+        while (i < size) {
+          if ((i & 7) == 0 && words[i >> 3] == 0) {
+            i += 8;
+          } else if (byte(i) == 0) {
+            i++;
+          } else {
+            break;
+          }
+        }
+        zeros = i - zeros;
+
+        // Literals run until two zero bytes in a row, or the end
+        auto start = i;
+        while (i < size && !(byte(i) == 0 && (i + 1 == size || byte(i + 1) == 0))) {
+          i++;
+        }
+
+        put_varint(out, zeros);
+        put_varint(out, i - start);
+        for (auto j = start; j < i; j++) {
+          out += (char) byte(j);
+        }
+      }
+    }
+
+    // Encodes `count` zero words without reading them
+    static void compress_zeros(size_t count, std::string& out) {
+      if (count > 0) {
+        put_varint(out, count * sizeof(uint64_t));
+        put_varint(out, 0);
+      }
+    }
+
+    // Returns false when `in` is malformed or does not fill `rows` exactly
+    static bool decompress(std::string_view in, std::vector<uint64_t>& rows) {
+      auto size = rows.size() * sizeof(uint64_t);
+      std::fill(rows.begin(), rows.end(), 0);
+
+      size_t i = 0;
+      while (!in.empty()) {
+        uint64_t zeros, literals;
+        if (!get_varint(in, zeros) || !get_varint(in, literals)) {
+          return false;
+        }
+        if (zeros > size - i || literals > size - i - zeros || literals > in.size()) {
+          return false;
+        }
+
+        i += zeros;
+        for (auto j = 0u; j < literals; j++, i++) {
+          rows[i / 8] |= (uint64_t) (uint8_t) in[j] << (8 * (i % 8));
+        }
+        in.remove_prefix(literals);
+      }
+      return i == size;
+    }
+};
@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Usage: ./compare.sh [engine1,engine2,...]
+# e.g. WORLD_WIDTH=4096 WORLD_HEIGHT=4096 ./compare.sh rowmajor,morton
+
+source ../helpers.sh
+
+ENGINES="${1:-rowmajor,morton}"
+
+echo -n "C++ - "
+g++ --version | head -n 1
+compile g++ -std=c++26 -O3 -o play play.cpp
+
+IFS=',' read -ra engines <<< "$ENGINES"
+for engine in "${engines[@]}"; do
+  echo "ENGINE=$engine"
+  benchmark env ENGINE="$engine" PERF=1 ./play
+done
@@ -0,0 +1,131 @@
+#include "bitwise.cpp"
+#include "memory.cpp"
+#include "seeding.cpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// PackedWorld for a size known at compile time, e.g. Play's default
+// 150x40. Both generations are held inline (about 2KB for 150x40, so it
+// fits in L1), rows are padded with a dead row above and below, and each
+// row kernel is unrolled across its words with the edges of the world
+// resolved at compile time, leaving no branches in the tick
+template <uint32_t W, uint32_t H>
+class FixedWorld {
+  public:
+    uint32_t tick = 0;
+
+    FixedWorld(uint32_t width, uint32_t height) {
+      if (width != W || height != H) {
+        throw SizeMismatch(width, height);
+      }
+      populate_cells();
+    }
+
+    void dotick() {
+      auto& cells = generations[tick % 2];
+      auto& target = generations[(tick + 1) % 2];
+      for (size_t y = 1; y <= H; y++) {
+        evolve_row(&cells[(y - 1) * WORDS], &cells[y * WORDS], &cells[(y + 1) * WORDS], &target[y * WORDS]);
+      }
+      tick++;
+    }
+
+    std::string render() {
+      std::string rendering(render_size(), ' ');
+      render_into(rendering.data());
+      return rendering;
+    }
+
+    size_t render_size() {
+      return (size_t) W * H + H;
+    }
+
+    size_t render_into(char* rendering) {
+      auto& cells = generations[tick % 2];
+      auto start = rendering;
+      for (size_t y = 1; y <= H; y++) {
+        for (uint32_t x = 0; x < W; x++) {
+          *rendering++ = (cells[y * WORDS + x / 64] >> (x % 64)) & 1 ? 'o' : ' ';
+        }
+        *rendering++ = '\n';
+      }
+      return rendering - start;
+    }
+
+    void clear() {
+      generations = {};
+    }
+
+    void set_alive(uint32_t x, uint32_t y) {
+      generations[tick % 2][(y + 1) * WORDS + x / 64] |= uint64_t(1) << (x % 64);
+    }
+
+    // Skips the dead padding rows above and below the world
+    void snapshot(std::vector<uint64_t>& rows) {
+      auto& cells = generations[tick % 2];
+      std::copy(cells.begin() + WORDS, cells.end() - WORDS, rows.begin());
+    }
+
+    MemoryUsage memory_usage() {
+      auto usage = MemoryUsage((uint64_t) W * H);
+      usage.add("Current", sizeof(Cells));
+      usage.add("Next", sizeof(Cells));
+      return usage;
+    }
+
+  private:
+    static constexpr size_t WORDS = (W + 63) / 64; // Per row
+    static constexpr uint64_t LAST_WORD_MASK = W % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (W % 64)) - 1;
+
+    using Cells = std::array<uint64_t, (H + 2) * WORDS>;
+
+    class SizeMismatch : public std::runtime_error {
+      public:
+        SizeMismatch(uint32_t width, uint32_t height):
+          std::runtime_error(std::format("SizeMismatch({}x{} is not {}x{})", width, height, W, H)) { }
+    };
+
+    std::array<Cells, 2> generations = {};
+
+    // Words beyond the sides of the world read as dead cells
+    template <ptrdiff_t I>
+    static uint64_t word(const uint64_t* cells) {
+      if constexpr (I < 0 || I >= (ptrdiff_t) WORDS) {
+        return 0;
+      } else {
+        return cells[I];
+      }
+    }
+
+    template <ptrdiff_t I>
+    static uint64_t evolve_word(const uint64_t* above, const uint64_t* cells, const uint64_t* below) {
+      auto evolved = Bitwise::evolve(
+        word<I - 1>(above), word<I>(above), word<I + 1>(above),
+        word<I - 1>(cells), word<I>(cells), word<I + 1>(cells),
+        word<I - 1>(below), word<I>(below), word<I + 1>(below)
+      );
+
+      // Keep the padding bits of the last word dead
+      if constexpr (I + 1 == WORDS) {
+        evolved &= LAST_WORD_MASK;
+      }
+      return evolved;
+    }
+
+    static void evolve_row(const uint64_t* above, const uint64_t* cells, const uint64_t* below, uint64_t* target) {
+      [&]<size_t... I>(std::index_sequence<I...>) {
+        ((target[I] = evolve_word<I>(above, cells, below)), ...);
+      }(std::make_index_sequence<WORDS>());
+    }
+
+    void populate_cells() {
+      Seeding::populate(W, H, [this](uint32_t x, uint32_t y) { set_alive(x, y); });
+    }
+};
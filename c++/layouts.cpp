@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Storage orders for ArrayWorld. Each maps (x, y) to an index into the
+// cell array, and visits every cell in the order it is stored in memory
+
+class RowMajor {
+  public:
+    RowMajor(uint32_t width, uint32_t height): width(width), height(height) { }
+
+    size_t size() {
+      return (size_t) width * height;
+    }
+
+    size_t index(uint32_t x, uint32_t y) {
+      return (size_t) y * width + x;
+    }
+
+    // Index of the in-bounds cell at (x + rel_x, y + rel_y)
+    size_t neighbour(size_t index, uint32_t /*x*/, uint32_t /*y*/, int rel_x, int rel_y) {
+      return index + (ptrdiff_t) rel_y * width + rel_x;
+    }
+
+    // Distance between rows when all neighbours are in bounds, otherwise 0
+    size_t stride(uint32_t x, uint32_t y) {
+      if (x == 0 || y == 0 || x + 1 >= width || y + 1 >= height) {
+        return 0;
+      }
+      return width;
+    }
+
+    template <typename F>
+    void each(F&& visit) {
+      for (auto y = 0u; y < height; y++) {
+        for (auto x = 0u; x < width; x++) {
+          visit(x, y, index(x, y));
+        }
+      }
+    }
+
+    size_t overhead() {
+      return 0;
+    }
+
+  private:
+    const uint32_t width;
+    const uint32_t height;
+};
+
+// Block-linear tiling along a Z-order (Morton) curve. Cells are grouped
+// into 16x16 tiles (four cache lines at a byte per cell) stored row-major,
+// and tiles are interleaved so that nearby tiles are nearby in memory at
+// every scale. Tile counts are padded up to powers of two per axis
+class Morton {
+  public:
+    static constexpr uint32_t TILE_BITS = 4;
+    static constexpr uint32_t TILE = 1 << TILE_BITS;
+
+    Morton(uint32_t width, uint32_t height): width(width), height(height) {
+      uint32_t x_bits = std::bit_width(std::bit_ceil((width + TILE - 1) / TILE) - 1);
+      uint32_t y_bits = std::bit_width(std::bit_ceil((height + TILE - 1) / TILE) - 1);
+
+      // Alternate x and y bits until the shorter axis runs out
+      for (auto bit = 0u; bit < std::max(x_bits, y_bits); bit++) {
+        if (bit < x_bits) {
+          x_positions.push_back(x_positions.size() + y_positions.size());
+        }
+        if (bit < y_bits) {
+          y_positions.push_back(x_positions.size() + y_positions.size());
+        }
+      }
+
+      columns = spread(1u << x_bits, x_positions);
+      rows = spread(1u << y_bits, y_positions);
+    }
+
+    size_t size() {
+      return (size_t) columns.size() * rows.size() * TILE * TILE;
+    }
+
+    size_t index(uint32_t x, uint32_t y) {
+      auto tile = columns[x >> TILE_BITS] | rows[y >> TILE_BITS];
+      return tile | ((y & (TILE - 1)) << TILE_BITS) | (x & (TILE - 1));
+    }
+
+    // Index of the in-bounds cell at (x + rel_x, y + rel_y), which is a
+    // plain offset unless it crosses into another tile
+    size_t neighbour(size_t index, uint32_t x, uint32_t y, int rel_x, int rel_y) {
+      auto tile_x = (x & (TILE - 1)) + rel_x;
+      auto tile_y = (y & (TILE - 1)) + rel_y;
+      if (tile_x < TILE && tile_y < TILE) {
+        return index + (ptrdiff_t) rel_y * TILE + rel_x;
+      }
+      return this->index(x + rel_x, y + rel_y);
+    }
+
+    // Distance between rows when all neighbours are in bounds and inside
+    // the same tile, otherwise 0
+    size_t stride(uint32_t x, uint32_t y) {
+      auto tile_x = x & (TILE - 1);
+      auto tile_y = y & (TILE - 1);
+      if (tile_x == 0 || tile_y == 0 || tile_x == TILE - 1 || tile_y == TILE - 1) {
+        return 0;
+      }
+      if (x + 1 >= width || y + 1 >= height) {
+        return 0;
+      }
+      return TILE;
+    }
+
+    template <typename F>
+    void each(F&& visit) {
+      auto tiles = columns.size() * rows.size();
+      for (size_t tile = 0; tile < tiles; tile++) {
+        auto left = gather(tile, x_positions) * TILE;
+        auto top = gather(tile, y_positions) * TILE;
+        if (left >= width || top >= height) {
+          continue; // Padding
+        }
+
+        auto right = std::min(left + TILE, width);
+        auto bottom = std::min(top + TILE, height);
+        auto index = tile << (2 * TILE_BITS);
+        for (auto y = top; y < bottom; y++) {
+          for (auto x = left; x < right; x++) {
+            visit(x, y, index + (x - left));
+          }
+          index += TILE;
+        }
+      }
+    }
+
+    size_t overhead() {
+      return (columns.capacity() + rows.capacity()) * sizeof(size_t);
+    }
+
+  private:
+    const uint32_t width;
+    const uint32_t height;
+    std::vector<uint32_t> x_positions; // Tile index bit for each bit of x
+    std::vector<uint32_t> y_positions;
+    std::vector<size_t> columns; // Tile x to its interleaved cell offset
+    std::vector<size_t> rows;
+
+    static std::vector<size_t> spread(uint32_t count, std::vector<uint32_t>& positions) {
+      std::vector<size_t> offsets(count, 0);
+      for (auto value = 0u; value < count; value++) {
+        for (auto bit = 0u; bit < positions.size(); bit++) {
+          if ((value >> bit) & 1) {
+            offsets[value] |= size_t(1) << (positions[bit] + 2 * TILE_BITS);
+          }
+        }
+      }
+      return offsets;
+    }
+
+    static uint32_t gather(size_t tile, std::vector<uint32_t>& positions) {
+      uint32_t value = 0;
+      for (auto bit = 0u; bit < positions.size(); bit++) {
+        value |= ((tile >> positions[bit]) & 1) << bit;
+      }
+      return value;
+    }
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class MemoryUsage {
+  public:
+    MemoryUsage(uint64_t cells): cells(cells) { }
+
+    void add(std::string_view component, uint64_t bytes) {
+      components.emplace_back(component, bytes);
+    }
+
+    std::string render() {
+      uint64_t total = 0;
+      std::string rendering = "Memory (";
+      for (auto& [component, bytes] : components) {
+        rendering += std::format("{}: {:.3f}; ", component, per_cell(bytes));
+        total += bytes;
+      }
+      rendering += std::format("Total: {:.3f} bytes/cell)", per_cell(total));
+      return rendering;
+    }
+
+  private:
+    const uint64_t cells;
+    std::vector<std::pair<std::string_view, uint64_t>> components;
+
+    double per_cell(uint64_t bytes) {
+      return (double) bytes / cells;
+    }
+};
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Worlds whose frames can be rendered straight into a FrameWriter slot.
+// `render_into` writes the same bytes as `render`, `render_size` of them,
+// into memory it does not own and returns how many it wrote, so a frame
+// needs no allocation or copy
+template <typename T>
+concept Renderable = requires(T& world, char* rendering) {
+  { world.render_size() } -> std::convertible_to<size_t>;
+  { world.render_into(rendering) } -> std::convertible_to<size_t>;
+};
+
+// Streams frames to a file descriptor without copying them. Frames are
+// rendered straight into slots of a page-aligned ring buffer, then handed
+// to the descriptor with writev, or with vmsplice when it is a pipe (on
+// Linux), which maps the pages into the pipe instead of copying them.
+// Each slot starts with room for a short header (e.g. the tick line),
+// which is placed directly before the frame so both go out together
+class FrameWriter {
+  public:
+    static constexpr size_t HEADER_SIZE = 256;
+
+    uint64_t bytes_written = 0;
+
+    FrameWriter(int fd, size_t frame_size): fd(fd) {
+      auto page_size = (size_t) sysconf(_SC_PAGESIZE);
+      slot_size = (HEADER_SIZE + frame_size + page_size - 1) / page_size * page_size;
+
+      // Pages handed to a pipe must not be rendered over until they are
+      // read. A pipe references at most capacity / page size pages, and
+      // each frame takes up at least `pages` of them, so once more frames
+      // than that have been written since, a slot is free to reuse
+      slots = 2;
+#ifdef __linux__
+      struct stat info;
+      if (fstat(fd, &info) == 0 && S_ISFIFO(info.st_mode)) {
+        auto capacity = fcntl(fd, F_GETPIPE_SZ);
+        if (capacity > 0) {
+          splice = true;
+          auto pages = std::max<size_t>(1, slot_size / page_size - 2);
+          auto pipe_pages = (size_t) capacity / page_size;
+          slots += (pipe_pages + pages - 1) / pages;
+        }
+      }
+#endif
+
+      buffer = (char*) mmap(nullptr, slots * slot_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (buffer == MAP_FAILED) {
+        throw OutputFailed("mmap");
+      }
+    }
+
+    ~FrameWriter() {
+      munmap(buffer, slots * slot_size);
+    }
+
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    // Where the next frame should be rendered
+    char* frame() {
+      return buffer + slot * slot_size + HEADER_SIZE;
+    }
+
+    void write(std::string_view header, size_t frame_size) {
+      header = header.substr(0, HEADER_SIZE);
+      auto frame_start = frame();
+      slot = (slot + 1) % slots;
+
+      if (splice) {
+        auto start = frame_start - header.size();
+        std::memcpy(start, header.data(), header.size());
+        iovec parts[] = {{start, header.size() + frame_size}};
+        send(parts, 1);
+      } else {
+        iovec parts[] = {
+          {(void*) header.data(), header.size()},
+          {frame_start, frame_size},
+        };
+        send(parts, 2);
+      }
+    }
+
+  private:
+    class OutputFailed : public std::runtime_error {
+      public:
+        OutputFailed(const char* call):
+          std::runtime_error(std::format("OutputFailed({}: {})", call, std::strerror(errno))) { }
+    };
+
+    const int fd;
+    bool splice = false;
+    size_t slot_size;
+    size_t slots;
+    size_t slot = 0;
+    char* buffer;
+
+    // Retries until everything is written, as pipes accept partial writes
+    void send(iovec* parts, int count) {
+      while (count > 0) {
+        ssize_t written;
+#ifdef __linux__
+        if (splice) {
+          written = vmsplice(fd, parts, count, 0);
+        } else {
+          written = writev(fd, parts, count);
+        }
+#else
+        written = writev(fd, parts, count);
+#endif
+        if (written < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          throw OutputFailed(splice ? "vmsplice" : "writev");
+        }
+        bytes_written += written;
+
+        while (count > 0 && (size_t) written >= parts->iov_len) {
+          written -= parts->iov_len;
+          parts++;
+          count--;
+        }
+        if (count > 0) {
+          parts->iov_base = (char*) parts->iov_base + written;
+          parts->iov_len -= written;
+        }
+      }
+    }
+};
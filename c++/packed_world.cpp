@@ -0,0 +1,233 @@
+#include "bitwise.cpp"
+#include "memory.cpp"
+#include "seeding.cpp"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A compact alternative to World, storing each cell as one bit in the
+// current generation and one bit in the next (2 bits per cell in total).
+// Only the bounding box of live cells, grown by one row and one word, is
+// stepped and rendered, which suits small patterns in large worlds
+class PackedWorld {
+  public:
+    uint32_t tick = 0;
+
+    PackedWorld(uint32_t width, uint32_t height):
+      width(width),
+      height(height),
+      words((width + 63) / 64),
+      current(words * height, 0),
+      next(words * height, 0),
+      live_rows(height, 0),
+      next_live_rows(height, 0) {
+      populate_cells();
+    }
+
+    // Kills every cell, e.g. before placing a pattern with `set_alive`
+    void clear() {
+      std::fill(current.begin(), current.end(), 0);
+      std::fill(next.begin(), next.end(), 0);
+      std::fill(live_rows.begin(), live_rows.end(), 0);
+      box = stale_box = forming_box = Box();
+    }
+
+    void set_alive(uint32_t x, uint32_t y) {
+      row(current, y)[x / 64] |= uint64_t(1) << (x % 64);
+      live_rows[y] = 1;
+      box.include(y, x / 64);
+    }
+
+    void dotick() {
+      determine_rows(0, height);
+      finish_tick();
+    }
+
+    // Splits dotick into slices of rows (see Scheduler). Rows are evolved
+    // into the next generation, which is swapped in by `finish_tick`, so
+    // unlike World there is no separate execute step
+    void determine_rows(uint32_t first, uint32_t last) {
+      auto scan = box.grow(height, words);
+
+      for (auto y = first; y < last; y++) {
+        auto target = row(next, y);
+
+        // Whatever two generations ago left behind is overwritten
+        if (stale_box.contains_row(y)) {
+          std::fill(target + stale_box.left, target + stale_box.right, 0);
+        }
+
+        next_live_rows[y] = 0;
+        if (!scan.contains_row(y)) {
+          continue;
+        }
+
+        auto above = y > 0 ? row(current, y - 1) : nullptr;
+        auto below = y + 1 < height ? row(current, y + 1) : nullptr;
+        auto live_above = above != nullptr && live_rows[y - 1];
+        auto live_below = below != nullptr && live_rows[y + 1];
+        if (!live_above && !live_rows[y] && !live_below) {
+          continue; // Nothing nearby to be born from
+        }
+
+        evolve_row(above, row(current, y), below, target, scan.left, scan.right);
+        for (auto i = scan.left; i < scan.right; i++) {
+          if (target[i] != 0) {
+            next_live_rows[y] = 1;
+            forming_box.include(y, i);
+          }
+        }
+      }
+    }
+
+    void finish_tick() {
+      std::swap(current, next);
+      std::swap(live_rows, next_live_rows);
+      stale_box = box;
+      box = forming_box;
+      forming_box = Box();
+      tick++;
+    }
+
+    std::string render() {
+      std::string rendering(render_size(), ' ');
+      render_into(rendering.data());
+      return rendering;
+    }
+
+    size_t render_size() {
+      return (size_t) width * height + height;
+    }
+
+    // Rows outside the bounding box are blanked without being read
+    size_t render_into(char* rendering) {
+      auto start = rendering;
+      for (auto y = 0u; y < height; y++) {
+        if (!box.contains_row(y)) {
+          rendering = std::fill_n(rendering, width, ' ');
+          *rendering++ = '\n';
+          continue;
+        }
+
+        auto cells = row(current, y);
+        for (auto i = 0u; i < words; i++) {
+          auto count = std::min(64u, width - i * 64);
+          if (cells[i] == 0) {
+            rendering = std::fill_n(rendering, count, ' ');
+            continue;
+          }
+
+          for (auto bit = 0u; bit < count; bit++) {
+            *rendering++ = (cells[i] >> bit) & 1 ? 'o' : ' ';
+          }
+        }
+        *rendering++ = '\n';
+      }
+      return rendering - start;
+    }
+
+    void snapshot(std::vector<uint64_t>& rows) {
+      std::copy(current.begin(), current.end(), rows.begin());
+    }
+
+    // Rows [first, last) that can differ from the previous generation,
+    // which only had live cells within `stale_box`
+    std::pair<uint32_t, uint32_t> changed_rows() {
+      auto first = std::min(box.top, stale_box.top);
+      auto last = std::max(box.bottom, stale_box.bottom);
+      if (first >= last) {
+        return {0, 0};
+      }
+      return {first, last};
+    }
+
+    void snapshot_rows(uint64_t* rows, uint32_t first, uint32_t last) {
+      std::copy(row(current, first), row(current, last), rows);
+    }
+
+    MemoryUsage memory_usage() {
+      auto usage = MemoryUsage((uint64_t) width * height);
+      usage.add("Current", current.capacity() * sizeof(uint64_t));
+      usage.add("Next", next.capacity() * sizeof(uint64_t));
+      usage.add("Live Rows", live_rows.capacity() + next_live_rows.capacity());
+      return usage;
+    }
+
+  private:
+    // Rows [top, bottom) and words [left, right) holding live cells
+    struct Box {
+      uint32_t top = UINT32_MAX;
+      uint32_t bottom = 0;
+      uint32_t left = UINT32_MAX;
+      uint32_t right = 0;
+
+      bool contains_row(uint32_t y) {
+        return y >= top && y < bottom;
+      }
+
+      void include(uint32_t y, uint32_t i) {
+        top = std::min(top, y);
+        bottom = std::max(bottom, y + 1);
+        left = std::min(left, i);
+        right = std::max(right, i + 1);
+      }
+
+      // Covers every cell that could be alive next generation
+      Box grow(uint32_t height, uint32_t words) {
+        if (bottom == 0) {
+          return Box(); // Nothing alive
+        }
+        return {
+          top > 0 ? top - 1 : 0,
+          std::min(bottom + 1, height),
+          left > 0 ? left - 1 : 0,
+          std::min(right + 1, words),
+        };
+      }
+    };
+
+    const uint32_t width;
+    const uint32_t height;
+    const uint32_t words; // Per row, the last one padded with dead cells
+    std::vector<uint64_t> current;
+    std::vector<uint64_t> next;
+    std::vector<uint8_t> live_rows; // Whether each row has any live cells
+    std::vector<uint8_t> next_live_rows;
+    Box box; // Of the current generation
+    Box stale_box; // Of the generation before, still held in `next`
+    Box forming_box; // Of the next generation, while it is determined
+
+    uint64_t* row(std::vector<uint64_t>& cells, uint32_t y) {
+      return cells.data() + (size_t) y * words;
+    }
+
+    // Evolves words [left, right) of a row into `target`
+    void evolve_row(uint64_t* above, uint64_t* cells, uint64_t* below, uint64_t* target, uint32_t left, uint32_t right) {
+      // Rows beyond the edges of the world are read as dead cells
+      auto word = [&](uint64_t* cells, int32_t i) -> uint64_t {
+        if (cells == nullptr || i < 0 || i >= (int32_t) words) {
+          return 0;
+        }
+        return cells[i];
+      };
+
+      for (auto i = (int32_t) left; i < (int32_t) right; i++) {
+        target[i] = Bitwise::evolve(
+          word(above, i - 1), word(above, i), word(above, i + 1),
+          word(cells, i - 1), word(cells, i), word(cells, i + 1),
+          word(below, i - 1), word(below, i), word(below, i + 1)
+        );
+      }
+
+      // Keep the padding bits of the last word dead
+      if (right == words && width % 64 != 0) {
+        target[words - 1] &= (uint64_t(1) << (width % 64)) - 1;
+      }
+    }
+
+    void populate_cells() {
+      Seeding::populate(width, height, [this](uint32_t x, uint32_t y) { set_alive(x, y); });
+    }
+};
@@ -0,0 +1,90 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware cache miss counters for the calling thread. Only Linux exposes
+// these (via perf_event_open), and only when perf_event_paranoid allows
+class CacheCounters {
+  public:
+    uint64_t l1d_misses = 0;
+    uint64_t llc_misses = 0;
+
+    CacheCounters() {
+#ifdef __linux__
+      auto l1d = PERF_COUNT_HW_CACHE_L1D
+        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      fds[0] = open(PERF_TYPE_HW_CACHE, l1d);
+      fds[1] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    }
+
+    ~CacheCounters() {
+#ifdef __linux__
+      for (auto fd : fds) {
+        if (fd >= 0) {
+          close(fd);
+        }
+      }
+#endif
+    }
+
+    CacheCounters(const CacheCounters&) = delete;
+    CacheCounters& operator=(const CacheCounters&) = delete;
+
+    bool available() {
+      return fds[0] >= 0 && fds[1] >= 0;
+    }
+
+    void start() {
+#ifdef __linux__
+      for (auto fd : fds) {
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+    }
+
+    // Accumulates the misses counted since `start`
+    void stop() {
+#ifdef __linux__
+      for (auto fd : fds) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      }
+      l1d_misses += take(fds[0]);
+      llc_misses += take(fds[1]);
+#endif
+    }
+
+  private:
+    std::array<int, 2> fds = {-1, -1};
+
+#ifdef __linux__
+    static int open(uint32_t type, uint64_t config) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = type;
+      attr.config = config;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    static uint64_t take(int fd) {
+      uint64_t count = 0;
+      if (read(fd, &count, sizeof(count)) != sizeof(count)) {
+        return 0;
+      }
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      return count;
+    }
+#endif
+};
@@ -1,9 +1,25 @@
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <chrono>
 #include <cstdlib>
 #include <ctime>
 #include <limits>
+#include <memory>
 #include <print>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "array_world.cpp"
+#include "fixed_world.cpp"
+#include "output.cpp"
+#include "packed_world.cpp"
+#include "perf.cpp"
+#include "recorder.cpp"
+#include "replayer.cpp"
+#include "scheduler.cpp"
 #include "world.cpp"
 
 class Play {
@@ -11,13 +27,82 @@ class Play {
     static constexpr int WORLD_WIDTH = 150;
     static constexpr int WORLD_HEIGHT = 40;
 
+    static constexpr std::array<std::pair<int, int>, 5> GLIDER = {{
+      {1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2},
+    }};
+
     static void run() {
-      auto world = World(
-        WORLD_WIDTH,
-        WORLD_HEIGHT
-      );
+      auto replay = std::getenv("REPLAY");
+      if (replay != nullptr) {
+        replay_recording(replay);
+        return;
+      }
+
+      auto engine = std::getenv("ENGINE");
+      auto name = std::string_view(engine ? engine : "world");
+
+      auto worlds = std::getenv("WORLDS");
+      if (worlds != nullptr) {
+        if (name == "world") {
+          schedule<World>(worlds);
+        } else if (name == "packed") {
+          schedule<PackedWorld>(worlds);
+        } else {
+          throw std::invalid_argument(std::format("ENGINE {} can not be scheduled", name));
+        }
+        return;
+      }
+
+      if (name == "world") {
+        simulate<World>();
+      } else if (name == "packed") {
+        simulate<PackedWorld>();
+      } else if (name == "fixed") {
+        simulate<FixedWorld<WORLD_WIDTH, WORLD_HEIGHT>>();
+      } else if (name == "rowmajor") {
+        simulate<ArrayWorld<RowMajor>>();
+      } else if (name == "morton") {
+        simulate<ArrayWorld<Morton>>();
+      } else {
+        throw std::invalid_argument(std::format("Unknown ENGINE: {}", name));
+      }
+    }
+
+  private:
+    template <typename T>
+    static void simulate() {
+      auto width = dimension("WORLD_WIDTH", WORLD_WIDTH);
+      auto height = dimension("WORLD_HEIGHT", WORLD_HEIGHT);
+
+      auto construct_start = std::chrono::high_resolution_clock::now();
+      auto world = T(width, height);
+      auto construct_finish = std::chrono::high_resolution_clock::now();
+      auto construct_time = std::chrono::duration<double, std::nano>(construct_finish - construct_start).count();
+
+      auto pattern = std::getenv("PATTERN");
+      if (pattern != nullptr) {
+        place_pattern(world, pattern);
+      }
+
+      if (std::getenv("STREAM") != nullptr) {
+        stream(world);
+        return;
+      }
 
       auto minimal = std::getenv("MINIMAL") != nullptr;
+      auto counters = CacheCounters();
+      auto count_misses = std::getenv("PERF") != nullptr && counters.available();
+
+      std::println("World Construction (T: {:.3f})", _f(construct_time));
+      std::println("{}", world.memory_usage().render());
+
+      // Recording happens within the tick, so its overhead is measured
+      auto recording = std::getenv("RECORD");
+      auto recorder = std::unique_ptr<Recorder>();
+      if (recording != nullptr) {
+        recorder = std::make_unique<Recorder>(recording, width, height);
+        recorder->record(world);
+      }
 
       if (!minimal) {
         std::print("{}", world.render());
@@ -29,9 +114,18 @@ class Play {
       auto lowest_render = std::numeric_limits<double>::infinity();
 
       while(true) {
+        if (count_misses) {
+          counters.start();
+        }
         auto tick_start = std::chrono::high_resolution_clock::now();
         world.dotick();
+        if (recorder) {
+          recorder->record(world);
+        }
         auto tick_finish = std::chrono::high_resolution_clock::now();
+        if (count_misses) {
+          counters.stop();
+        }
         auto tick_time = std::chrono::duration<double, std::nano>(tick_finish - tick_start).count();
         total_tick += tick_time;
         lowest_tick = std::min(lowest_tick, tick_time);
@@ -49,13 +143,23 @@ class Play {
           std::print("\u001b[H\u001b[2J");
         }
 
+        auto misses = std::string();
+        if (count_misses) {
+          misses = std::format(
+            " - Cache Misses (L1D: {}; LLC: {})",
+            counters.l1d_misses / world.tick,
+            counters.llc_misses / world.tick
+          );
+        }
+
         std::println(
-          "#{} - World Tick (L: {:.3f}; A: {:.3f}) - Rendering (L: {:.3f}; A: {:.3f})",
+          "#{} - World Tick (L: {:.3f}; A: {:.3f}) - Rendering (L: {:.3f}; A: {:.3f}){}",
           world.tick,
           _f(lowest_tick),
           _f(avg_tick),
           _f(lowest_render),
-          _f(avg_render)
+          _f(avg_render),
+          misses
         );
 
         if (!minimal) {
@@ -64,10 +168,182 @@ class Play {
       }
     }
 
-  private:
+    // Writes frames to stdout as fast as possible, reporting throughput
+    // on stderr once a second and when done, e.g. `STREAM=1 ./play | consumer`.
+    // STREAM_MB stops after that many megabytes (0, the default, never does)
+    template <Renderable T>
+    static void stream(T& world) {
+      auto writer = FrameWriter(STDOUT_FILENO, world.render_size());
+      auto limit = (uint64_t) dimension("STREAM_MB", 0) * 1'000'000;
+      char header[48] = "\u001b[H\u001b[2J#";
+      auto header_start = std::char_traits<char>::length(header);
+
+      auto started = std::chrono::high_resolution_clock::now();
+      auto reported = started;
+      uint64_t frames = 0;
+
+      auto report = [&](auto now) {
+        auto elapsed = std::chrono::duration<double>(now - started).count();
+        std::println(
+          stderr,
+          "#{} - Streaming (MB/s: {:.3f}; Frames/s: {:.1f})",
+          world.tick,
+          writer.bytes_written / elapsed / 1'000'000.0,
+          frames / elapsed
+        );
+      };
+
+      while(limit == 0 || writer.bytes_written < limit) {
+        world.dotick();
+        auto size = world.render_into(writer.frame());
+
+        auto [end, _] = std::to_chars(header + header_start, header + sizeof(header) - 1, world.tick);
+        *end++ = '\n';
+        writer.write(std::string_view(header, end - header), size);
+        frames++;
+
+        auto now = std::chrono::high_resolution_clock::now();
+        if (now - reported >= std::chrono::seconds(1)) {
+          reported = now;
+          report(now);
+        }
+      }
+      report(std::chrono::high_resolution_clock::now());
+    }
+
+    // Replaces the random cells with a single pattern in the top left,
+    // e.g. PATTERN=glider to watch one glider cross a large empty world
+    template <typename T>
+    static void place_pattern(T& world, std::string_view name) {
+      if constexpr (requires { world.clear(); }) {
+        if (name != "glider") {
+          throw std::invalid_argument(std::format("Unknown PATTERN: {}", name));
+        }
+
+        world.clear();
+        for (auto& [x, y] : GLIDER) {
+          world.set_alive(x, y);
+        }
+      } else {
+        throw std::invalid_argument("PATTERN requires ENGINE=packed or fixed");
+      }
+    }
+
+    // Interleaves many worlds, e.g. WORLDS=150x40,150x40,4096x4096, across
+    // THREADS threads (at most one per world), printing the progress of each
+    // once a second
+    template <typename T>
+    static void schedule(std::string_view worlds) {
+      auto threads = dimension("THREADS", std::max(1u, std::thread::hardware_concurrency()));
+      auto cells_per_slice = dimension("SLICE_CELLS", 65536);
+      auto scheduler = Scheduler(threads);
+
+      while (!worlds.empty()) {
+        auto comma = worlds.find(',');
+        auto size = worlds.substr(0, comma);
+        worlds.remove_prefix(comma == std::string_view::npos ? worlds.size() : comma + 1);
+
+        auto separator = size.find('x');
+        if (separator == std::string_view::npos) {
+          throw std::invalid_argument(std::format("Invalid world size: {}", size));
+        }
+        auto width = (uint32_t) std::strtoul(std::string(size.substr(0, separator)).c_str(), nullptr, 10);
+        auto height = (uint32_t) std::strtoul(std::string(size.substr(separator + 1)).c_str(), nullptr, 10);
+
+        scheduler.add(
+          std::string(size),
+          Scheduler::simulate(T(width, height), width, height, cells_per_slice)
+        );
+      }
+
+      scheduler.start();
+
+      while(true) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        for (auto& stats : scheduler.stats()) {
+          std::println(
+            "#{} - {} - Slices: {} - Generation Latency (L: {:.3f}; A: {:.3f}; H: {:.3f}) - Throughput (G/s: {:.1f})",
+            stats.generations,
+            stats.name,
+            stats.slices,
+            _f(stats.lowest_latency),
+            _f(stats.average_latency),
+            _f(stats.highest_latency),
+            stats.throughput
+          );
+        }
+      }
+    }
+
+    static void replay_recording(const char* path) {
+      auto replayer = Replayer(path);
+      auto minimal = std::getenv("MINIMAL") != nullptr;
+
+      auto seek = std::getenv("SEEK");
+      auto target = seek ? std::strtoul(seek, nullptr, 10) : 0;
+      auto seek_start = std::chrono::high_resolution_clock::now();
+      auto found = replayer.seek(target);
+      auto seek_finish = std::chrono::high_resolution_clock::now();
+      auto seek_time = std::chrono::duration<double, std::nano>(seek_finish - seek_start).count();
+
+      if (!found) {
+        std::println("No recorded generation at or before #{}", target);
+        return;
+      }
+
+      std::println("Replay Seek (T: {:.3f})", _f(seek_time));
+
+      if (!minimal) {
+        std::print("{}", replayer.render());
+      }
+
+      auto total_step = 0.0;
+      auto lowest_step = std::numeric_limits<double>::infinity();
+      auto steps = 0;
+
+      while (replayer.generation < replayer.last_generation()) {
+        auto step_start = std::chrono::high_resolution_clock::now();
+        if (!replayer.next()) {
+          break;
+        }
+        auto step_finish = std::chrono::high_resolution_clock::now();
+        auto step_time = std::chrono::duration<double, std::nano>(step_finish - step_start).count();
+        total_step += step_time;
+        lowest_step = std::min(lowest_step, step_time);
+        steps++;
+        auto avg_step = total_step / steps;
+
+        if (!minimal) {
+          std::print("\u001b[H\u001b[2J");
+        }
+
+        std::println(
+          "#{} - Replay Step (L: {:.3f}; A: {:.3f})",
+          replayer.generation,
+          _f(lowest_step),
+          _f(avg_step)
+        );
+
+        if (!minimal) {
+          std::print("{}", replayer.render());
+        }
+      }
+    }
+
     static double _f(double value) {
       return value / 1'000'000.0;
     }
+
+    // Allows larger worlds to be benchmarked, e.g. WORLD_WIDTH=4096
+    static uint32_t dimension(const char* name, uint32_t fallback) {
+      auto value = std::getenv(name);
+      if (value == nullptr) {
+        return fallback;
+      }
+
+      return std::strtoul(value, nullptr, 10);
+    }
 };
 
 int main () {
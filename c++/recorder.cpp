@@ -0,0 +1,213 @@
+#include "codec.cpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Worlds Recorder can take frames from. `snapshot` packs every cell into
+// `rows`, 64 cells per word as described in Codec, with each row starting
+// on a new word. Worlds that can tell which rows may differ from the
+// previous generation also provide `changed_rows`, returning rows
+// [first, last), and `snapshot_rows`, copying just those, so each frame
+// only holds what changed
+template <typename T>
+concept Recordable = requires(T& world, std::vector<uint64_t>& rows) {
+  { world.tick } -> std::convertible_to<uint32_t>;
+  world.snapshot(rows);
+};
+
+// Streams every generation to a file or pipe for later replay. Each one
+// is written as a record of (type byte, varint generation, varint payload
+// length, payload), where the payload is the packed rows (keyframes, 'K')
+// or those rows XOR'd with the previous generation (deltas, 'D'). See
+// Codec for the encoding. Compression and writing happen on a background
+// thread, so the ticking thread only copies the packed rows, and only
+// those that may have changed when the world can say which (see
+// `changed_rows`). `record` must therefore see every generation
+//
+// Frames pass through a ring of SLOTS preallocated buffers with one
+// producer (`record`) and one consumer (the writer), so `record` takes no
+// lock unless the ring is full or an idle writer needs waking
+class Recorder {
+  public:
+    static constexpr uint32_t SLOTS = 64; // Frames queued before `record` blocks
+    static constexpr uint32_t BATCH = 16; // Frames before an idle writer is woken
+    static constexpr auto POLL = std::chrono::milliseconds(10); // Idle writer's wait for a partial batch
+
+    Recorder(const std::string& path, uint32_t width, uint32_t height, uint32_t keyframe_interval = 256):
+      row_words((width + 63) / 64),
+      height(height),
+      keyframe_interval(keyframe_interval),
+      slots(SLOTS) {
+      file = std::fopen(path.c_str(), "wb");
+      if (file == nullptr) {
+        throw RecordingFailed(path);
+      }
+
+      std::string header(Codec::MAGIC, sizeof(Codec::MAGIC));
+      Codec::put_varint(header, width);
+      Codec::put_varint(header, height);
+      Codec::put_varint(header, keyframe_interval);
+      std::fwrite(header.data(), 1, header.size(), file);
+
+      writer = std::thread([this] { write_frames(); });
+    }
+
+    ~Recorder() {
+      finished = true;
+      {
+        auto lock = std::lock_guard(mutex);
+      }
+      frames_ready.notify_one();
+      writer.join();
+      std::fclose(file);
+    }
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    template <Recordable T>
+    void record(T& world) {
+      auto first = 0u;
+      auto last = height;
+      if constexpr (requires { world.changed_rows(); }) {
+        if (recorded) {
+          std::tie(first, last) = world.changed_rows();
+        }
+      }
+      recorded = true;
+
+      // Waits for the writer to free a slot when all are queued
+      auto head = this->head.load(std::memory_order_relaxed);
+      auto tail = this->tail.load(std::memory_order_acquire);
+      while (head - tail == SLOTS) {
+        this->tail.wait(tail, std::memory_order_acquire);
+        tail = this->tail.load(std::memory_order_acquire);
+      }
+
+      // Slot buffers only grow, so after the first lap nothing is allocated
+      auto& frame = slots[head % SLOTS];
+      frame.generation = world.tick;
+      frame.first = first;
+      frame.last = last;
+      frame.rows.resize((size_t) (last - first) * row_words);
+      if constexpr (requires { world.changed_rows(); }) {
+        world.snapshot_rows(frame.rows.data(), first, last);
+      } else {
+        world.snapshot(frame.rows);
+      }
+      this->head.store(head + 1); // Ordered before reading `writer_idle`
+
+      if ((head + 1) % BATCH == 0 && writer_idle) {
+        {
+          auto lock = std::lock_guard(mutex);
+        }
+        frames_ready.notify_one();
+      }
+    }
+
+  private:
+    // Packed rows [first, last) of a generation; the rest are unchanged
+    struct Frame {
+      uint32_t generation = 0;
+      uint32_t first = 0;
+      uint32_t last = 0;
+      std::vector<uint64_t> rows;
+    };
+
+    class RecordingFailed : public std::runtime_error {
+      public:
+        RecordingFailed(const std::string& path):
+          std::runtime_error(std::format("RecordingFailed({})", path)) { }
+    };
+
+    const size_t row_words;
+    const uint32_t height;
+    const uint32_t keyframe_interval;
+    bool recorded = false; // Only touched by the recording thread
+    std::FILE* file;
+    std::thread writer;
+    std::vector<Frame> slots;
+    std::atomic<uint32_t> head = 0; // Next slot `record` fills
+    std::atomic<uint32_t> tail = 0; // Next slot the writer takes
+    std::atomic<bool> writer_idle = false;
+    std::atomic<bool> finished = false;
+    std::mutex mutex; // Only guards the idle writer's wait
+    std::condition_variable frames_ready;
+
+    void write_frames() {
+      std::vector<uint64_t> board(row_words * height); // Latest generation
+      std::vector<uint64_t> delta;
+      std::string payload;
+      std::string record;
+      auto first = true;
+
+      auto tail = 0u;
+      while (true) {
+        auto head = this->head.load(std::memory_order_acquire);
+        if (head == tail) {
+          if (finished && this->head.load(std::memory_order_acquire) == tail) {
+            return; // Finished and drained
+          }
+
+          // Sleeps until a batch is queued, or POLL passes for a partial one
+          auto lock = std::unique_lock(mutex);
+          writer_idle = true;
+          frames_ready.wait_for(lock, POLL, [this, tail] {
+            return finished || this->head.load() != tail;
+          });
+          writer_idle = false;
+          continue;
+        }
+
+        for (; tail != head; tail++) {
+          write_frame(slots[tail % SLOTS], board, delta, payload, record, first);
+          this->tail.store(tail + 1, std::memory_order_release);
+        }
+        std::fflush(file); // A killed run then only loses queued frames
+        this->tail.notify_one();
+      }
+    }
+
+    void write_frame(Frame& frame, std::vector<uint64_t>& board, std::vector<uint64_t>& delta, std::string& payload, std::string& record, bool& first) {
+      // Replays can only start from keyframes, so the first one is too
+      auto keyframe = first || frame.generation % keyframe_interval == 0;
+      first = false;
+
+      // Rows outside the frame are unchanged, so their delta is all zeros
+      auto start = (size_t) frame.first * row_words;
+      auto changed = frame.rows.size();
+      payload.clear();
+      if (keyframe) {
+        std::copy(frame.rows.begin(), frame.rows.end(), board.begin() + start);
+        Codec::compress(board.data(), board.size(), payload);
+      } else {
+        delta.resize(changed);
+        for (size_t i = 0; i < changed; i++) {
+          delta[i] = frame.rows[i] ^ board[start + i];
+          board[start + i] = frame.rows[i];
+        }
+        Codec::compress_zeros(start, payload);
+        Codec::compress(delta.data(), changed, payload);
+        Codec::compress_zeros(board.size() - start - changed, payload);
+      }
+
+      record.clear();
+      record += keyframe ? 'K' : 'D';
+      Codec::put_varint(record, frame.generation);
+      Codec::put_varint(record, payload.size());
+      record += payload;
+      std::fwrite(record.data(), 1, record.size(), file);
+    }
+};
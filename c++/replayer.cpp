@@ -0,0 +1,186 @@
+#include "codec.cpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Plays back a file written by Recorder. Records are indexed on open so
+// `seek` can jump to the nearest earlier keyframe and replay deltas on
+// top of it, rather than decoding the whole recording
+class Replayer {
+  public:
+    uint32_t generation = 0;
+
+    Replayer(const std::string& path) {
+      file = std::fopen(path.c_str(), "rb");
+      if (file == nullptr) {
+        throw ReplayFailed(path);
+      }
+
+      char magic[sizeof(Codec::MAGIC)];
+      if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic)
+          || !std::equal(magic, magic + sizeof(magic), Codec::MAGIC)) {
+        throw ReplayFailed(path);
+      }
+
+      uint64_t keyframe_interval;
+      if (!read_varint(width) || !read_varint(height) || !read_varint(keyframe_interval)) {
+        throw ReplayFailed(path);
+      }
+
+      index_records();
+      rows.assign((width + 63) / 64 * height, 0);
+      delta.assign(rows.size(), 0);
+    }
+
+    ~Replayer() {
+      std::fclose(file);
+    }
+
+    Replayer(const Replayer&) = delete;
+    Replayer& operator=(const Replayer&) = delete;
+
+    uint32_t last_generation() {
+      return records.empty() ? 0 : records.back().generation;
+    }
+
+    // Moves to the latest recorded generation at or before `target`
+    bool seek(uint32_t target) {
+      auto after = std::upper_bound(
+        records.begin(), records.end(), target,
+        [](uint32_t target, const Record& record) { return target < record.generation; }
+      );
+      if (after == records.begin()) {
+        return false;
+      }
+
+      auto keyframe = after - 1;
+      while (!keyframe->keyframe) {
+        if (keyframe == records.begin()) {
+          return false;
+        }
+        keyframe--;
+      }
+
+      for (auto record = keyframe; record != after; record++) {
+        if (!apply(*record)) {
+          return false;
+        }
+      }
+      position = after - records.begin();
+      return true;
+    }
+
+    // Moves to the next recorded generation
+    bool next() {
+      if (position >= records.size()) {
+        return false;
+      }
+      return apply(records[position++]);
+    }
+
+    std::string render() {
+      auto words = (width + 63) / 64;
+      uint32_t render_size = width * height + height;
+      std::string rendering;
+      rendering.reserve(render_size);
+      for (auto y = 0u; y < height; y++) {
+        for (auto x = 0u; x < width; x++) {
+          auto word = rows[(size_t) y * words + x / 64];
+          rendering += (word >> (x % 64)) & 1 ? 'o' : ' ';
+        }
+        rendering += '\n';
+      }
+      return rendering;
+    }
+
+  private:
+    struct Record {
+      uint32_t generation;
+      bool keyframe;
+      long offset; // Of the payload
+      uint64_t size;
+    };
+
+    class ReplayFailed : public std::runtime_error {
+      public:
+        ReplayFailed(const std::string& path):
+          std::runtime_error(std::format("ReplayFailed({})", path)) { }
+    };
+
+    std::FILE* file;
+    uint64_t width;
+    uint64_t height;
+    std::vector<Record> records;
+    size_t position = 0; // Next record to apply
+    std::vector<uint64_t> rows;
+    std::vector<uint64_t> delta;
+    std::string payload;
+
+    bool read_varint(uint64_t& value) {
+      value = 0;
+      for (auto shift = 0; shift < 64; shift += 7) {
+        auto byte = std::fgetc(file);
+        if (byte == EOF) {
+          return false;
+        }
+        value |= (uint64_t) (byte & 0x7f) << shift;
+        if (byte < 0x80) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // A truncated final record (e.g. from a killed recording) is ignored
+    void index_records() {
+      auto start = std::ftell(file);
+      std::fseek(file, 0, SEEK_END);
+      auto end = std::ftell(file);
+      std::fseek(file, start, SEEK_SET);
+
+      while (true) {
+        auto type = std::fgetc(file);
+        uint64_t generation, size;
+        if (type == EOF || !read_varint(generation) || !read_varint(size)) {
+          return;
+        }
+
+        auto offset = std::ftell(file);
+        if (size > (uint64_t) (end - offset)) {
+          return;
+        }
+        std::fseek(file, size, SEEK_CUR);
+
+        records.push_back({(uint32_t) generation, type == 'K', offset, size});
+      }
+    }
+
+    bool apply(const Record& record) {
+      payload.resize(record.size);
+      std::fseek(file, record.offset, SEEK_SET);
+      if (std::fread(payload.data(), 1, record.size, file) != record.size) {
+        return false;
+      }
+
+      if (record.keyframe) {
+        if (!Codec::decompress(payload, rows)) {
+          return false;
+        }
+      } else {
+        if (!Codec::decompress(payload, delta)) {
+          return false;
+        }
+        for (size_t i = 0; i < rows.size(); i++) {
+          rows[i] ^= delta[i];
+        }
+      }
+
+      generation = record.generation;
+      return true;
+    }
+};
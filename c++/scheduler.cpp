@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// A simulation that suspends itself after every slice of work, yielding
+// true once a whole generation has been completed
+class Slices {
+  public:
+    struct promise_type {
+      bool generation_finished = false;
+      std::exception_ptr exception;
+
+      Slices get_return_object() {
+        return Slices(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      std::suspend_always final_suspend() noexcept { return {}; }
+      void return_void() { }
+
+      std::suspend_always yield_value(bool finished) {
+        generation_finished = finished;
+        return {};
+      }
+
+      void unhandled_exception() {
+        exception = std::current_exception();
+      }
+    };
+
+    Slices(Slices&& other): handle(std::exchange(other.handle, nullptr)) { }
+
+    ~Slices() {
+      if (handle) {
+        handle.destroy();
+      }
+    }
+
+    // Runs the next slice, returning whether it finished a generation
+    bool resume() {
+      handle.resume();
+      if (handle.promise().exception) {
+        std::rethrow_exception(handle.promise().exception);
+      }
+      return handle.promise().generation_finished;
+    }
+
+  private:
+    std::coroutine_handle<promise_type> handle;
+
+    Slices(std::coroutine_handle<promise_type> handle): handle(handle) { }
+};
+
+// Runs many simulations across a fixed pool of threads, each with its own
+// queue of worlds. A worker runs one world for a quantum of QUANTUM_NS of
+// thread time without touching any shared state, then rebalances: it
+// moves on to the next world in its own queue, or steals from another
+// worker's queue when that holds a world that is further behind. The
+// victim is always the worker holding the least served waiting world, so
+// identical worlds get equal throughput, and because slices are bounded,
+// big worlds cannot starve small ones. With a world per worker, each
+// world stays on its thread. Idle workers sleep until a world is queued
+class Scheduler {
+  public:
+    static constexpr int64_t QUANTUM_NS = 1'000'000; // Thread time per world between rebalances
+
+    struct Stats {
+      std::string name;
+      uint64_t generations;
+      uint64_t slices;
+      double lowest_latency; // Wall time per generation, including waiting
+      double average_latency;
+      double highest_latency;
+      double throughput; // Generations per second
+    };
+
+    Scheduler(uint32_t threads): threads(std::max(1u, threads)) { }
+
+    ~Scheduler() {
+      running = false;
+      {
+        auto lock = std::lock_guard(idle_mutex);
+      }
+      job_queued.notify_all();
+      workers.clear(); // Joins
+    }
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Each slice covers whole rows, about `cells_per_slice` cells in total
+    template <typename T>
+    static Slices simulate(T world, uint32_t width, uint32_t height, uint32_t cells_per_slice) {
+      auto rows = std::max(1u, cells_per_slice / std::max(1u, width));
+      while (true) {
+        for (auto first = 0u; first < height; first += rows) {
+          world.determine_rows(first, std::min(first + rows, height));
+          co_yield false;
+        }
+        if constexpr (requires { world.execute_rows(0u, 0u); }) {
+          for (auto first = 0u; first < height; first += rows) {
+            world.execute_rows(first, std::min(first + rows, height));
+            co_yield false;
+          }
+        }
+        world.finish_tick();
+        co_yield true;
+      }
+    }
+
+    // Worlds can only be added before `start`
+    void add(std::string name, Slices slices) {
+      jobs.push_back(std::make_unique<Job>(std::move(name), std::move(slices)));
+    }
+
+    // More workers than worlds would only leave some idle, so the pool is
+    // capped at one per world. Worlds are dealt out round-robin and
+    // rebalanced from there
+    void start() {
+      started = now();
+      queues = std::vector<Queue>(std::min<size_t>(threads, jobs.size()));
+      for (size_t i = 0; i < jobs.size(); i++) {
+        jobs[i]->generation_started = started;
+        queues[i % queues.size()].jobs.push_back(jobs[i].get());
+      }
+      queued = jobs.size();
+
+      running = true;
+      for (size_t worker = 0; worker < queues.size(); worker++) {
+        workers.emplace_back([this, worker] { work(worker); });
+      }
+    }
+
+    // Rethrows the first exception raised by any world, after which all
+    // workers have stopped
+    std::vector<Stats> stats() {
+      {
+        auto lock = std::lock_guard(failure_mutex);
+        if (failure) {
+          std::rethrow_exception(failure);
+        }
+      }
+
+      auto elapsed = (now() - started) / 1e9;
+      std::vector<Stats> stats;
+      for (auto& job : jobs) {
+        auto generations = job->generations.load();
+        stats.push_back({
+          job->name,
+          generations,
+          job->slices_run.load(),
+          (double) job->lowest_latency.load(),
+          generations ? (double) job->total_latency.load() / generations : 0.0,
+          (double) job->highest_latency.load(),
+          elapsed > 0 ? generations / elapsed : 0.0,
+        });
+      }
+      return stats;
+    }
+
+  private:
+    // Everything but the atomics is only touched by the worker holding the
+    // job, or under the lock of the queue it sits in
+    struct Job {
+      std::string name;
+      Slices slices;
+      int64_t busy = 0; // Thread time spent running its slices
+      int64_t generation_started = 0;
+      std::atomic<uint64_t> generations = 0;
+      std::atomic<uint64_t> slices_run = 0;
+      std::atomic<int64_t> lowest_latency = 0;
+      std::atomic<int64_t> total_latency = 0;
+      std::atomic<int64_t> highest_latency = 0;
+
+      Job(std::string name, Slices slices): name(std::move(name)), slices(std::move(slices)) { }
+    };
+
+    struct Queue {
+      std::mutex mutex;
+      std::deque<Job*> jobs;
+    };
+
+    const uint32_t threads;
+    std::vector<std::unique_ptr<Job>> jobs;
+    std::vector<Queue> queues;
+    std::vector<std::jthread> workers;
+    std::atomic<bool> running = false;
+    std::atomic<size_t> queued = 0; // Jobs waiting in any queue
+    std::atomic<uint32_t> sleepers = 0;
+    std::mutex idle_mutex; // Only guards idle workers' waits
+    std::condition_variable job_queued;
+    std::mutex failure_mutex;
+    std::exception_ptr failure;
+    int64_t started = 0;
+
+    static int64_t now() {
+      auto time = std::chrono::steady_clock::now().time_since_epoch();
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+    }
+
+    void work(size_t worker) {
+      Job* job = nullptr;
+      int64_t quantum_end = 0;
+      while (true) {
+        if (job != nullptr && job->busy < quantum_end) {
+          if (!run(*job)) {
+            return;
+          }
+          continue;
+        }
+
+        if (!running) {
+          return;
+        }
+
+        job = rebalance(worker, job);
+        if (job == nullptr) {
+          auto lock = std::unique_lock(idle_mutex);
+          sleepers++;
+          job_queued.wait(lock, [this] { return !running || queued > 0; });
+          sleepers--;
+          continue;
+        }
+        quantum_end = job->busy + QUANTUM_NS;
+      }
+    }
+
+    // Picks the world to run next, which may be `current` again: the least
+    // served world in another worker's queue if it is a quantum behind
+    // both `current` and the front of this worker's queue, else that front
+    // if it is behind `current`
+    Job* rebalance(size_t worker, Job* current) {
+      Job* best = current;
+      auto& own = queues[worker];
+      {
+        auto lock = std::lock_guard(own.mutex);
+        if (!own.jobs.empty() && (best == nullptr || own.jobs.front()->busy < best->busy)) {
+          best = own.jobs.front();
+        }
+      }
+
+      // Least served waiting world on any other worker
+      Queue* victim = nullptr;
+      Job* stolen = nullptr;
+      for (size_t i = 1; i < queues.size(); i++) {
+        auto& queue = queues[(worker + i) % queues.size()];
+        auto lock = std::lock_guard(queue.mutex);
+        for (auto job : queue.jobs) {
+          if (stolen == nullptr || job->busy < stolen->busy) {
+            victim = &queue;
+            stolen = job;
+          }
+        }
+      }
+
+      if (stolen != nullptr && (best == nullptr || stolen->busy + QUANTUM_NS < best->busy)) {
+        best = take(*victim, stolen) ? stolen : current;
+      } else if (best != current) {
+        best = take(own, best) ? best : current;
+      }
+
+      if (current != nullptr && best != current) {
+        {
+          auto lock = std::lock_guard(own.mutex);
+          own.jobs.push_back(current);
+        }
+        queued++;
+        if (sleepers > 0) {
+          {
+            auto lock = std::lock_guard(idle_mutex);
+          }
+          job_queued.notify_one();
+        }
+      }
+      return best;
+    }
+
+    // Fails when another worker has taken `job` since the queue was read
+    bool take(Queue& queue, Job* job) {
+      auto lock = std::lock_guard(queue.mutex);
+      auto found = std::find(queue.jobs.begin(), queue.jobs.end(), job);
+      if (found == queue.jobs.end()) {
+        return false;
+      }
+      queue.jobs.erase(found);
+      queued--;
+      return true;
+    }
+
+    // Returns false once a world has failed, after which nothing runs
+    bool run(Job& job) {
+      auto slice_started = now();
+      try {
+        if (job.slices.resume()) {
+          record_generation(job);
+        }
+      } catch (...) {
+        {
+          auto lock = std::lock_guard(failure_mutex);
+          if (!failure) {
+            failure = std::current_exception();
+          }
+        }
+        running = false;
+        {
+          auto lock = std::lock_guard(idle_mutex);
+        }
+        job_queued.notify_all();
+        return false;
+      }
+      job.busy += now() - slice_started;
+      job.slices_run.store(job.slices_run.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return true;
+    }
+
+    void record_generation(Job& job) {
+      auto finished = now();
+      auto latency = finished - job.generation_started;
+      job.generation_started = finished;
+
+      if (job.generations == 0 || latency < job.lowest_latency) {
+        job.lowest_latency = latency;
+      }
+      if (latency > job.highest_latency) {
+        job.highest_latency = latency;
+      }
+      job.total_latency += latency;
+      job.generations++;
+    }
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+// Seeds the alternative engines the way World::populate_cells does, so a
+// given std::srand seed gives the same starting world in each of them
+class Seeding {
+  public:
+    // Calls `set_alive(x, y)` for each cell that starts alive (about 20%),
+    // drawing one std::rand per cell in row-major order
+    template <typename F>
+    static void populate(uint32_t width, uint32_t height, F&& set_alive) {
+      for (auto y = 0u; y < height; y++) {
+        for (auto x = 0u; x < width; x++) {
+          auto random = (double) std::rand() / RAND_MAX;
+          if (random <= 0.2) {
+            set_alive(x, y);
+          }
+        }
+      }
+    }
+};
@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# Usage: ./stream.sh [engine]
+# Measures how fast generations can be streamed to a downstream consumer,
+# both into a file (writev) and through a pipe (vmsplice on Linux)
+
+source ../helpers.sh
+
+ENGINE="${1:-packed}"
+
+if [ "${QUICK}" = "true" ]; then
+  TIMEOUT_SECS=5
+else
+  TIMEOUT_SECS=30
+fi
+
+echo -n "C++ - "
+g++ --version | head -n 1
+compile g++ -std=c++26 -O3 -o play play.cpp
+
+# A real file, as /dev/null would discard writes without any I/O. Fast
+# engines write hundreds of MB a second and /tmp is often in memory, so
+# the run stops after STREAM_MB megabytes and the file is removed after
+STREAM_MB="${STREAM_MB:-1024}"
+OUTPUT="$(mktemp)"
+trap 'rm -f "$OUTPUT"' EXIT
+
+echo "ENGINE=$ENGINE into a file ($OUTPUT, up to $STREAM_MB MB)"
+timeout -s9 "$TIMEOUT_SECS" env ENGINE="$ENGINE" STREAM=1 STREAM_MB="$STREAM_MB" ./play 2>&1 >"$OUTPUT" | tail -n 1
+rm -f "$OUTPUT"
+
+echo "ENGINE=$ENGINE through a pipe"
+{ timeout -s9 "$TIMEOUT_SECS" env ENGINE="$ENGINE" STREAM=1 ./play | cat >/dev/null; } 2>&1 | tail -n 1
@@ -1,4 +1,5 @@
 #include "cell.cpp"
+#include "memory.cpp"
 // #include <sstream>
 #include <array>
 #include <charconv>
@@ -6,6 +7,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -39,6 +41,32 @@ class World {
       tick++;
     }
 
+    // Splits dotick into slices of rows so it can be interleaved with other
+    // work (see Scheduler). All rows must be determined, then all executed,
+    // before `finish_tick`
+    void determine_rows(uint32_t first, uint32_t last) {
+      for (auto cell = grid.begin() + first * width; cell != grid.begin() + last * width; cell++) {
+        auto alive_neighbours = (*cell)->alive_neighbours();
+        if (!(*cell)->alive && alive_neighbours == 3) {
+          (*cell)->next_state = true;
+        } else if (alive_neighbours < 2 || alive_neighbours > 3) {
+          (*cell)->next_state = false;
+        } else {
+          (*cell)->next_state = (*cell)->alive;
+        }
+      }
+    }
+
+    void execute_rows(uint32_t first, uint32_t last) {
+      for (auto cell = grid.begin() + first * width; cell != grid.begin() + last * width; cell++) {
+        (*cell)->alive = (*cell)->next_state.value();
+      }
+    }
+
+    void finish_tick() {
+      tick++;
+    }
+
     std::string render() {
       // The following is the fastest
       uint32_t render_size = width * height + height;
@@ -69,6 +97,63 @@ class World {
       // return rendering.str();
     }
 
+    void snapshot(std::vector<uint64_t>& rows) {
+      auto word = rows.begin();
+      auto cell = grid.begin();
+      for (auto y = 0u; y < height; y++) {
+        for (auto x = 0u; x < width; x += 64) {
+          uint64_t bits = 0;
+          auto count = std::min(64u, width - x);
+          for (auto bit = 0u; bit < count; bit++, cell++) {
+            bits |= uint64_t((*cell)->alive) << bit;
+          }
+          *word++ = bits;
+        }
+      }
+    }
+
+    MemoryUsage memory_usage() {
+      auto usage = MemoryUsage(cells.size());
+
+      // Node sizes are estimated from their contents (next pointer, key,
+      // value and cached hash), excluding any allocator overhead
+      uint64_t cell_bytes = 0;
+      uint64_t node_bytes = cells.bucket_count() * sizeof(void*);
+      uint64_t key_bytes = 0;
+      uint64_t neighbour_bytes = 0;
+      for (auto& [key, cell] : cells) {
+        cell_bytes += sizeof(Cell);
+        node_bytes += sizeof(void*) + sizeof(cell) + sizeof(size_t);
+        key_bytes += sizeof(key);
+        if (key.capacity() > std::string().capacity()) {
+          key_bytes += key.capacity() + 1; // Too long for small string storage
+        }
+        neighbour_bytes += cell->neighbours.capacity() * sizeof(Cell*);
+      }
+
+      usage.add("Cells", cell_bytes);
+      usage.add("Map Nodes", node_bytes);
+      usage.add("Keys", key_bytes);
+      usage.add("Neighbours", neighbour_bytes);
+      usage.add("Grid", grid.capacity() * sizeof(Cell*));
+      return usage;
+    }
+
+    size_t render_size() {
+      return (size_t) width * height + height;
+    }
+
+    size_t render_into(char* rendering) {
+      auto start = rendering;
+      for (auto cell = grid.begin(); cell != grid.end(); cell++) {
+        *rendering++ = (*cell)->to_char();
+        if ((*cell)->x + 1 == width) {
+          *rendering++ = '\n';
+        }
+      }
+      return rendering - start;
+    }
+
   private:
     struct string_hash {
       using is_transparent = void;
@@ -80,6 +165,7 @@ class World {
     const uint32_t width;
     const uint32_t height;
     std::unordered_map<std::string, std::unique_ptr<Cell>, string_hash, std::equal_to<>> cells;
+    std::vector<Cell*> grid; // Row-major index into `cells`
 
     class LocationOccupied : public std::runtime_error {
       public:
@@ -118,17 +204,38 @@ class World {
     }
 
     void populate_cells() {
-      for (auto y = 0; y < height; y++) {
-        for (auto x = 0; x < width; x++) {
+      cells.reserve(width * height);
+      grid.assign(width * height, nullptr);
+
+      // Alive states are drawn in row-major order so a seed gives the same
+      // world as before, then the cells are allocated in parallel bands
+      std::vector<uint8_t> alive(width * height);
+      for (auto y = 0u; y < height; y++) {
+        for (auto x = 0u; x < width; x++) {
           auto random = (double) std::rand() / RAND_MAX;
-          auto alive = random <= 0.2;
-          add_cell(x, y, alive);
+          alive[y * width + x] = random <= 0.2;
+        }
+      }
+
+      std::vector<std::unique_ptr<Cell>> allocated(width * height);
+      each_band([&](uint32_t first, uint32_t last) {
+        for (auto y = first; y < last; y++) {
+          for (auto x = 0u; x < width; x++) {
+            allocated[y * width + x] = std::make_unique<Cell>(x, y, alive[y * width + x]);
+          }
         }
+      });
+
+      for (auto& cell : allocated) {
+        add_cell(std::move(cell));
       }
     }
 
-    bool add_cell(uint32_t x, uint32_t y, bool alive = false) {
-      auto existing = cell_at(x, y);
+    // Takes an already allocated cell, so allocation can happen in parallel
+    bool add_cell(std::unique_ptr<Cell> cell) {
+      auto x = cell->x;
+      auto y = cell->y;
+      auto existing = grid[y * width + x];
       if (existing) {
         throw LocationOccupied(x, y);
       }
@@ -136,32 +243,75 @@ class World {
       char buf[24];
       auto key = std::string(make_key(buf, x, y));
 
-      auto cell = std::make_unique<Cell>(x, y, alive);
-      cells[key] = std::move(cell);
+      grid[y * width + x] = cell.get();
+      cells.emplace(std::move(key), std::move(cell));
       return true;
     }
 
+    // Runs `work` on one band of rows per core, returning once all are done
+    template <typename F>
+    void each_band(F&& work) {
+      auto threads = std::max(1u, std::thread::hardware_concurrency());
+      auto band = (height + threads - 1) / threads;
+      std::vector<std::jthread> workers;
+      for (uint32_t first = 0; first < height; first += band) {
+        auto last = std::min(first + band, height);
+        workers.emplace_back([&work, first, last] { work(first, last); });
+      }
+    }
+
     void prepopulate_neighbours() {
-      for (auto& [_, cell] : cells) {
-        auto x = (int)cell->x;
-        auto y = (int)cell->y;
-
-        for (auto& [rel_x, rel_y] : DIRECTIONS) {
-          auto nx = x + rel_x;
-          auto ny = y + rel_y;
-          if (nx < 0 || ny < 0) {
-            continue; // Out of bounds
-          }
+      // The following is the fastest
+      // Rows are linked in parallel bands, resolving each neighbour by its
+      // row-major index instead of formatting a key and probing the map
+      each_band([this](uint32_t first, uint32_t last) { link_rows(first, last); });
 
-          auto ux = (uint32_t)nx;
-          auto uy = (uint32_t)ny;
-          if (ux >= width || uy >= height) {
-            continue; // Out of bounds
-          }
+      // The following is slower
+      // for (auto& [_, cell] : cells) {
+      //   auto x = (int)cell->x;
+      //   auto y = (int)cell->y;
+      //
+      //   for (auto& [rel_x, rel_y] : DIRECTIONS) {
+      //     auto nx = x + rel_x;
+      //     auto ny = y + rel_y;
+      //     if (nx < 0 || ny < 0) {
+      //       continue; // Out of bounds
+      //     }
+      //
+      //     auto ux = (uint32_t)nx;
+      //     auto uy = (uint32_t)ny;
+      //     if (ux >= width || uy >= height) {
+      //       continue; // Out of bounds
+      //     }
+      //
+      //     auto neighbour = cell_at(ux, uy);
+      //     if (neighbour) {
+      //       cell->neighbours.push_back(neighbour);
+      //     }
+      //   }
+      // }
+    }
+
+    void link_rows(uint32_t first, uint32_t last) {
+      for (auto y = first; y < last; y++) {
+        for (auto x = 0u; x < width; x++) {
+          auto cell = grid[y * width + x];
+          cell->neighbours.reserve(DIRECTIONS.size());
+
+          for (auto& [rel_x, rel_y] : DIRECTIONS) {
+            auto nx = (int)x + rel_x;
+            auto ny = (int)y + rel_y;
+            if (nx < 0 || ny < 0) {
+              continue; // Out of bounds
+            }
+
+            auto ux = (uint32_t)nx;
+            auto uy = (uint32_t)ny;
+            if (ux >= width || uy >= height) {
+              continue; // Out of bounds
+            }
 
-          auto neighbour = cell_at(ux, uy);
-          if (neighbour) {
-            cell->neighbours.push_back(neighbour);
+            cell->neighbours.push_back(grid[uy * width + ux]);
           }
         }
       }
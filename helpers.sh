@@ -64,6 +64,12 @@ function benchmark_iterations {
     output=$(run_pty env MINIMAL=1 timeout -s9 $TIMEOUT_SECS "$@" 2>&1 | tr '\r' '\n')
     result=$(echo "$output" | grep -E '\)\s*$' | tail -n 1)
 
+    # Implementations that time their setup report it once on startup
+    construction=$(echo "$output" | grep -E '^World Construction' | head -n 1)
+    if [ -n "$construction" ]; then
+      echo "$construction"
+    fi
+
     if [ -n "$result" ]; then
       echo "$result"
     else
@@ -83,6 +89,12 @@ function benchmark_memory {
   output=$(MINIMAL=1 node ../sample.js $TIMEOUT_SECS "$@" 2>&1)
   result=$(echo "$output" | grep "Max RSS")
 
+  # Implementations with in-process accounting break it down per cell
+  breakdown=$(echo "$output" | grep -E '^Memory \(' | head -n 1)
+  if [ -n "$breakdown" ]; then
+    echo "$breakdown"
+  fi
+
   if [ -n "$result" ]; then
     echo "$result"
   else